@@ -6,6 +6,7 @@ November 7th, 2023
 
 #include <stdio.h>
 #include <stdlib.h>
+#include <stddef.h>
 #include <string.h>
 #include <ctype.h>
 #include <fcntl.h>
@@ -14,6 +15,8 @@ November 7th, 2023
 
 #define MAX_WORD_LENGTH 100 //change for dictionary word length
 #define DEFAULT_THREAD_COUNT 16 //amount of concurrent threads prepared for at compile-time
+#define ARENA_BLOCK_SIZE 65536 //minimum size of each block in a task's working memory arena
+#define ARENA_ALIGNMENT _Alignof(max_align_t) //every arena allocation starts on this boundary
 
 /*
 Global variables
@@ -21,6 +24,7 @@ Global variables
 static char terminationFlag = 0;
 static pthread_mutex_t mutexPrintControl; //which thread has the right to print
 static pthread_mutex_t mutexMenu; //to allow menu to wait for option from user
+static pthread_mutex_t mutexThreadTracking; //guards currentThreadsCount and activeThreads
 static pthread_cond_t menuCondition;
 static pthread_t menuThread;
 static int menuInput;
@@ -31,6 +35,15 @@ static char* activeThreads;
 /*
 Structs
 */
+typedef struct{
+    int allocations;
+    int blocksCreated;
+    size_t bytesInUse;
+    size_t peakBytesInUse;
+    size_t bytesReserved;
+    size_t peakBytesReserved;
+}arenaStats;
+
 typedef struct{
     char fileName[MAX_WORD_LENGTH];
     char dictionaryName[MAX_WORD_LENGTH];
@@ -39,6 +52,7 @@ typedef struct{
     int topMistakesFrequency[5];
     int mistakesCount;
     int threadIndex;
+    arenaStats memoryStats;
 
 }threadArgs;
 
@@ -47,14 +61,34 @@ typedef struct{
     int frequency;
 }dictionaryWords;
 
+typedef struct arenaBlock{
+    struct arenaBlock* next; //previously filled block
+    size_t size;
+    size_t used;
+    max_align_t data[]; //max_align_t keeps the start of the block suitably aligned
+}arenaBlock;
+
+typedef struct{
+    arenaBlock* head; //block currently being filled
+    void* lastAllocation; //most recent allocation, the only one arenaGrow can extend in place
+    arenaStats stats;
+}taskArena;
+
+//working memory of the task running on this thread. Zeroed for every new thread, freed in one shot by releaseTask
+static _Thread_local taskArena taskMemory;
+
 /*
 Function definitions
 */
 void *spellCheck( void* argPtr );
 int existsInDictionary( dictionaryWords* Dictionary, int dictionaryCount, char* newWord );
-int evaluateLevenshtein( dictionaryWords* Dictionary, int dictionaryCount, char* newWord );
-int LevenshteinDistance( char* dictWord, char* newWord );
+int evaluateLevenshtein( dictionaryWords* Dictionary, int dictionaryCount, char* newWord, int* levenshteinRows );
+int LevenshteinDistance( char* dictWord, char* newWord, int* levenshteinRows );
 int minimum(int a, int b, int c);
+void *arenaAlloc( size_t size );
+void *arenaGrow( void* ptr, size_t oldSize, size_t newSize );
+void releaseArena( void );
+void releaseTask( threadArgs *fArgs );
 void printControl( threadArgs *fArgs );
 void *getMenuInput();
 
@@ -80,7 +114,6 @@ void *spellCheck( void* argPtr ){
     int maxWords = 64;
     char* dictBuffer;
     size_t wordLen = 0;
-    size_t maxWordLen = MAX_WORD_LENGTH;
 
     //variables for copying file
     char *fileData;
@@ -90,17 +123,22 @@ void *spellCheck( void* argPtr ){
     char newWord[MAX_WORD_LENGTH];
     char* fileDataWords;
     char* savePtr;
-
-    Dictionary = (dictionaryWords*) malloc(sizeof(dictionaryWords) * maxWords); //initializes memory for 64 dictionary words of length Max_Word_Length
-    dictBuffer = malloc(MAX_WORD_LENGTH);
+    int* levenshteinRows;
+
+    //all working memory comes from this thread's arena. dictBuffer goes first so Dictionary can grow in place above it
+    dictBuffer = arenaAlloc(MAX_WORD_LENGTH + 1); //room for the longest word, '\n' and '\0'
+    Dictionary = (dictionaryWords*) arenaAlloc(sizeof(dictionaryWords) * maxWords); //initializes memory for 64 dictionary words of length Max_Word_Length
+    if(!dictBuffer || !Dictionary){
+        write(STDOUT_FILENO, "Error: Could not allocate Dictionary.\n", 38);
+        releaseTask(fArgs);
+        pthread_exit(NULL);
+    }
     //populate Dictionary from dictionaryName
     if ((fp = fopen(fArgs->dictionaryName, "r")) != NULL){
-        while((wordLen = getline(&dictBuffer, &maxWordLen, fp)) != -1){
+        while(fgets(dictBuffer, MAX_WORD_LENGTH + 1, fp) != NULL){
             if(terminationFlag){ //in case of early termination
-                //free Dictionary & close fp
                 fclose(fp);
-                free(Dictionary);
-                free(dictBuffer);
+                releaseTask(fArgs);
                 pthread_exit(NULL);
             }
             //printf("dictBuffer: %s", dictBuffer);
@@ -108,31 +146,35 @@ void *spellCheck( void* argPtr ){
                 //printf("Have: %d, Need: %d\n", currentWords, maxWords);
                 maxWords *= 2;
                 //printf("New alloc size: %d\n", maxWords);
-                dictionaryWords* temp = realloc(Dictionary, (sizeof(dictionaryWords) * maxWords));
+                dictionaryWords* temp = arenaGrow(Dictionary, (sizeof(dictionaryWords) * (maxWords / 2)), (sizeof(dictionaryWords) * maxWords));
                 if (temp != NULL){
                     Dictionary = temp;
                 }
                 else{
                     write(STDOUT_FILENO, "Error: Could not realloc Dictionary.\n", 37);
-                    //free Dictionary & close fp
                     fclose(fp);
-                    free(Dictionary);
-                    free(dictBuffer);
+                    releaseTask(fArgs);
                     pthread_exit(NULL);
                 }
             }
-            strncpy(Dictionary[currentWords].word, dictBuffer, wordLen - 1); //copy word into dictionary struct, minus '\n'
+            if(strchr(dictBuffer, '\n') == NULL && !feof(fp)){ //line too long for dictBuffer, discard the rest so it is not read as another word
+                int discarded;
+                while((discarded = fgetc(fp)) != '\n' && discarded != EOF);
+            }
+            wordLen = strcspn(dictBuffer, "\n"); //copy word into dictionary struct, minus '\n'
+            if(wordLen > MAX_WORD_LENGTH - 1){
+                wordLen = MAX_WORD_LENGTH - 1;
+            }
+            memcpy(Dictionary[currentWords].word, dictBuffer, wordLen);
+            Dictionary[currentWords].word[wordLen] = '\0';
             Dictionary[currentWords].frequency = 0;
-            //printf("%s, size: %ld, index: %d\n", Dictionary[currentWords].word, wordLen - 1, currentWords);
+            //printf("%s, size: %ld, index: %d\n", Dictionary[currentWords].word, wordLen, currentWords);
             currentWords++;
         }
         if(fp){
             fclose(fp);
             fp = NULL;
         }
-        if(dictBuffer){
-            free(dictBuffer);
-        }
     }
     else{
         //mutex for printing
@@ -140,14 +182,7 @@ void *spellCheck( void* argPtr ){
         printf("Error: Could not open dictionary: %s.\nTerminating thread.\n\n", fArgs->dictionaryName);
         pthread_mutex_unlock(&mutexPrintControl);
 
-        //free Dictionary
-        free(Dictionary);
-        free(dictBuffer);
-
-        //update thread tracking variables
-        currentThreadsCount--;
-        activeThreads[fArgs->threadIndex] = 0;
-
+        releaseTask(fArgs);
         pthread_exit(NULL);
     }
 
@@ -156,22 +191,15 @@ void *spellCheck( void* argPtr ){
         fseek(fp, 0L, SEEK_END);
 		fileSize = ftell(fp);
 		fseek(fp, 0L, SEEK_SET);
-		fileData = malloc(fileSize + 1);
+		fileData = arenaAlloc(fileSize + 1);
         if(!fileData){ //check successful malloc
             //mutex for printing
             pthread_mutex_lock(&mutexPrintControl);
 			printf("Error: Malloc for %s unsuccessful.\nTerminating thread.\n\n", fArgs->fileName);
             pthread_mutex_unlock(&mutexPrintControl);
-            
-            //free Dictionary & close fp
-            fclose(fp);
-            free(Dictionary);
-            free(fileData);
-
-            //update thread tracking variables
-            currentThreadsCount--;
-            activeThreads[fArgs->threadIndex] = 0;
 
+            fclose(fp);
+            releaseTask(fArgs);
 			pthread_exit(NULL);
 		}
 		if(fread(fileData, fileSize, 1, fp) < 1){ //check successful copy
@@ -180,37 +208,47 @@ void *spellCheck( void* argPtr ){
 			printf("Error: Could not read from file: %s.\nTerminating thread.\n\n", fArgs->fileName);
             pthread_mutex_unlock(&mutexPrintControl);
 
-            //free Dictionary & close fp
             fclose(fp);
-            free(Dictionary);
-            free(fileData);
-
-            //update thread tracking variables
-            currentThreadsCount--;
-            activeThreads[fArgs->threadIndex] = 0;
-
+            releaseTask(fArgs);
 			pthread_exit(NULL);
 		}
+        fileData[fileSize] = '\0';
         if(fp){
             fclose(fp);
             fp = NULL;
         }
     }
+    else{
+        //mutex for printing
+        pthread_mutex_lock(&mutexPrintControl);
+        printf("Error: Could not open file: %s.\nTerminating thread.\n\n", fArgs->fileName);
+        pthread_mutex_unlock(&mutexPrintControl);
+
+        releaseTask(fArgs);
+        pthread_exit(NULL);
+    }
+
+    //two DP rows, reused by every Levenshtein comparison this task makes
+    levenshteinRows = arenaAlloc(sizeof(int) * 2 * (MAX_WORD_LENGTH + 1));
+    if(!levenshteinRows){
+        write(STDOUT_FILENO, "Error: Could not allocate Levenshtein rows.\n", 44);
+        releaseTask(fArgs);
+        pthread_exit(NULL);
+    }
 
     //tokenize & act on each word
     fileDataWords = strtok_r(fileData, " ,.-!?\n\r", &savePtr);
     while(fileDataWords){
         if(terminationFlag){ //in case of early termination
-            //free Dictionary & close fp
-            free(Dictionary);
-            free(fileData);
+            releaseTask(fArgs);
             pthread_exit(NULL);
         }
         //printf("%s word\n", fileDataWords);
-        strcpy(newWord, fileDataWords);
+        strncpy(newWord, fileDataWords, MAX_WORD_LENGTH - 1); //truncate long tokens to fit newWord and levenshteinRows
+        newWord[MAX_WORD_LENGTH - 1] = '\0';
         newWord[0] = tolower(newWord[0]);
         if(!existsInDictionary(Dictionary, currentWords, newWord)){ //if new word from stream is not found in Dictionary
-            int closestWordIndex = evaluateLevenshtein(Dictionary, currentWords, newWord);
+            int closestWordIndex = evaluateLevenshtein(Dictionary, currentWords, newWord, levenshteinRows);
             if(closestWordIndex){
                 Dictionary[closestWordIndex].frequency += 1;
                 //printf("works: %s, %d\n", Dictionary[closestWordIndex].word, Dictionary[closestWordIndex].frequency);
@@ -260,32 +298,22 @@ void *spellCheck( void* argPtr ){
                 printf("Error: Could not determine Levenshtein distance for: %s.\n", newWord);
                 pthread_mutex_unlock(&mutexPrintControl);
                 
-                //free Dictionary
-                free(Dictionary);
-                free(fileData);
-
-                //update thread tracking variables
-                currentThreadsCount--;
-                activeThreads[fArgs->threadIndex] = 0;
-
+                releaseTask(fArgs);
                 pthread_exit(NULL);
             }
         }
         fileDataWords = strtok_r(NULL, " ,.-!?\n\r", &savePtr);
     }
 
+    //hand arena statistics to the task report
+    fArgs->memoryStats = taskMemory.stats;
+
     //mutex for printing
     pthread_mutex_lock(&mutexPrintControl);
     printControl(fArgs);
     pthread_mutex_unlock(&mutexPrintControl);
 
-    //free Dictionary
-    free(Dictionary);
-    free(fileData);
-
-    //update thread tracking variables
-    currentThreadsCount--;
-    activeThreads[fArgs->threadIndex] = 0;
+    releaseTask(fArgs);
 
     return NULL;
 }
@@ -319,15 +347,15 @@ int existsInDictionary( dictionaryWords* Dictionary, int dictionaryCount, char*
 
 /*
 Description: A helper function for threads to check the Levenshtein Distance for the misspelled word by calling a helper function.
-Input: The saved dictionary, the number of terms in the dictionary, and the word to check.
+Input: The saved dictionary, the number of terms in the dictionary, the word to check, and the task's Levenshtein rows.
 Output: Returns the index of the closest correct word.
 */
-int evaluateLevenshtein( dictionaryWords* Dictionary, int dictionaryCount, char* newWord ){
+int evaluateLevenshtein( dictionaryWords* Dictionary, int dictionaryCount, char* newWord, int* levenshteinRows ){
     int lowestLevenshtein = 128;
     int lowestIndex = -1;
     for(int i = 0; i < dictionaryCount; i++){
         //printf("checking: %s to %s: Levenshtein: ", Dictionary[i].word, newWord);
-        int newLevenshtein = LevenshteinDistance(Dictionary[i].word, newWord);
+        int newLevenshtein = LevenshteinDistance(Dictionary[i].word, newWord, levenshteinRows);
         //printf("%d\n", newLevenshtein);
         if(lowestLevenshtein > newLevenshtein){
             lowestLevenshtein = newLevenshtein;
@@ -341,31 +369,24 @@ int evaluateLevenshtein( dictionaryWords* Dictionary, int dictionaryCount, char*
 }
 
 /*
-Levenshtein Distance algorithm - Iterative with full matrix similar to wiki
+Levenshtein Distance algorithm - Iterative with two matrix rows
 Description: A helper function for evaluateLevenshtein, that checks the Levenshtein Distance for the misspelled word on one Dictionary word.
-Input: The saved dictionary, the number of terms in the dictionary, and the word to check.
+Input: The Dictionary word, the word to check, and room for two rows of (MAX_WORD_LENGTH + 1) ints from the task's arena.
 Output: Returns their levenshtein distance.
 */
-int LevenshteinDistance( char* dictWord, char* newWord ){
+int LevenshteinDistance( char* dictWord, char* newWord, int* levenshteinRows ){
     int x = strlen(dictWord);
     int y = strlen(newWord);
-    int array[x + 1][y + 1];
-    for(int i = 1; i < x; i++){
-        for(int j = 1; j < y; j++){
-            array[i][j] = 0;
-        }
-    }
+    int* previousRow = levenshteinRows;
+    int* currentRow = levenshteinRows + (y + 1);
 
-    for(int i = 0; i <= x; i++){
-        array[i][0] = i;
-    }
     for(int j = 0; j <= y; j++){
-        array[0][j] = j;
+        previousRow[j] = j;
     }
-    //printf("Array %s:\n", dictWord); //for debugging: printing the array
 
     int substitutionCost = -1;
     for(int i = 1; i <= x; i++){
+        currentRow[0] = i;
         for(int j = 1; j <= y; j++){
             if(dictWord[i - 1] == newWord[j - 1]){
                 substitutionCost = 0;
@@ -373,13 +394,16 @@ int LevenshteinDistance( char* dictWord, char* newWord ){
             else{
                 substitutionCost = 1;
             }
-            array[i][j] = minimum(array[i - 1][j] + 1, array[i][j - 1] + 1, array[i - 1][j - 1] + substitutionCost);
-            //printf("%d ", array[i][j]); //for debugging: printing the array
+            currentRow[j] = minimum(previousRow[j] + 1, currentRow[j - 1] + 1, previousRow[j - 1] + substitutionCost);
+            //printf("%d ", currentRow[j]); //for debugging: printing the array
         }
         //printf("\n"); //for debugging: printing the array
+        int* tempRow = previousRow; //the finished row becomes the previous row
+        previousRow = currentRow;
+        currentRow = tempRow;
     }
 
-    return array[x][y];
+    return previousRow[y];
 }
 
 /*
@@ -399,6 +423,131 @@ int minimum(int a, int b, int c){
     }
 }
 
+/*
+Description: A helper function for the arena that puts a new block on top of this thread's arena.
+Input: The smallest number of bytes the block must hold.
+Output: Returns the new block, or NULL if malloc failed.
+*/
+arenaBlock *newArenaBlock( size_t minimumSize ){
+    size_t size = ARENA_BLOCK_SIZE;
+    if(size < minimumSize){
+        size = minimumSize;
+    }
+
+    arenaBlock* block = malloc(sizeof(arenaBlock) + size);
+    if(!block){
+        return NULL;
+    }
+    block->next = taskMemory.head;
+    block->size = size;
+    block->used = 0;
+    taskMemory.head = block;
+
+    taskMemory.stats.blocksCreated++;
+    taskMemory.stats.bytesReserved += size;
+    if(taskMemory.stats.peakBytesReserved < taskMemory.stats.bytesReserved){
+        taskMemory.stats.peakBytesReserved = taskMemory.stats.bytesReserved;
+    }
+    return block;
+}
+
+/*
+Description: Bump allocator for a task's working memory. Nothing is freed individually, releaseArena frees it all at once.
+Input: The number of bytes wanted.
+Output: Returns aligned memory from this thread's arena, or NULL if a new block could not be malloc'd.
+*/
+void *arenaAlloc( size_t size ){
+    size = (size + ARENA_ALIGNMENT - 1) / ARENA_ALIGNMENT * ARENA_ALIGNMENT;
+
+    arenaBlock* block = taskMemory.head;
+    if(!block || block->size - block->used < size){
+        block = newArenaBlock(size);
+        if(!block){
+            return NULL;
+        }
+    }
+    void* ptr = (char*)block->data + block->used;
+    block->used += size;
+    taskMemory.lastAllocation = ptr;
+
+    taskMemory.stats.allocations++;
+    taskMemory.stats.bytesInUse += size;
+    if(taskMemory.stats.peakBytesInUse < taskMemory.stats.bytesInUse){
+        taskMemory.stats.peakBytesInUse = taskMemory.stats.bytesInUse;
+    }
+    return ptr;
+}
+
+/*
+Description: The arena's realloc. Extends the most recent allocation in place when its block has room, otherwise copies it
+to a new allocation. A block left holding nothing but the old copy is freed straight away.
+Input: The allocation to grow (or NULL), its current size, and the size wanted.
+Output: Returns the grown allocation, or NULL (leaving the old one intact) if a new block could not be malloc'd.
+*/
+void *arenaGrow( void* ptr, size_t oldSize, size_t newSize ){
+    arenaBlock* block = taskMemory.head;
+    oldSize = (oldSize + ARENA_ALIGNMENT - 1) / ARENA_ALIGNMENT * ARENA_ALIGNMENT;
+    newSize = (newSize + ARENA_ALIGNMENT - 1) / ARENA_ALIGNMENT * ARENA_ALIGNMENT;
+
+    if(ptr && ptr == taskMemory.lastAllocation){
+        size_t offset = (char*)ptr - (char*)block->data;
+        if(block->size - offset >= newSize){ //extend in place
+            block->used = offset + newSize;
+            taskMemory.stats.bytesInUse += newSize - oldSize;
+            if(taskMemory.stats.peakBytesInUse < taskMemory.stats.bytesInUse){
+                taskMemory.stats.peakBytesInUse = taskMemory.stats.bytesInUse;
+            }
+            return ptr;
+        }
+    }
+
+    void* newPtr = arenaAlloc(newSize);
+    if(!newPtr || !ptr){
+        return newPtr;
+    }
+    memcpy(newPtr, ptr, oldSize);
+    taskMemory.stats.bytesInUse -= oldSize;
+
+    if(taskMemory.head != block && ptr == (void*)block->data && block->used == oldSize){ //old block only held ptr
+        taskMemory.head->next = block->next;
+        taskMemory.stats.bytesReserved -= block->size;
+        free(block);
+    }
+    return newPtr;
+}
+
+/*
+Description: Frees every block in this thread's arena in one shot. Statistics are kept for the task report.
+Input: N/A
+Output: Does not return anything.
+*/
+void releaseArena( void ){
+    while(taskMemory.head){
+        arenaBlock* block = taskMemory.head;
+        taskMemory.head = block->next;
+        free(block);
+    }
+    taskMemory.lastAllocation = NULL;
+    taskMemory.stats.bytesInUse = 0;
+    taskMemory.stats.bytesReserved = 0;
+}
+
+/*
+Description: The one exit path for a task, whether it completed, failed, or was cancelled through terminationFlag.
+Releases the task's working memory and updates the thread tracking variables.
+Input: The arguments of the ending thread.
+Output: Does not return anything. Callers still pthread_exit or return afterwards.
+*/
+void releaseTask( threadArgs *fArgs ){
+    releaseArena();
+
+    //update thread tracking variables. The thread touches no shared data after this, so main may free it once the flag is cleared
+    pthread_mutex_lock(&mutexThreadTracking);
+    currentThreadsCount--;
+    activeThreads[fArgs->threadIndex] = 0;
+    pthread_mutex_unlock(&mutexThreadTracking);
+}
+
 /*
 Description: A simple helper function used by main that returns the lowest available thread space in the array.
 Input: The active thread array, and its size.
@@ -464,6 +613,8 @@ void printControl( threadArgs *fArgs ){
     for(int i = 0; i < 5; i++){
         printf("%s: %s, %d\n", fArgs->topMistakes[i], fArgs->topCorrection[i], fArgs->topMistakesFrequency[i]);
     }
+    printf("Working memory: %zu bytes peak in %d allocations, %d blocks (%zu bytes reserved at peak)\n",
+        fArgs->memoryStats.peakBytesInUse, fArgs->memoryStats.allocations, fArgs->memoryStats.blocksCreated, fArgs->memoryStats.peakBytesReserved);
 
     pthread_create(&menuThread, NULL, getMenuInput, NULL); //restart menu
 }
@@ -480,7 +631,10 @@ void *getMenuInput(){
         printf("%c ", activeThreads[i] + '0');
     }
     printf("\n");*/
-    printf("Active Threads: %d\n", currentThreadsCount);
+    pthread_mutex_lock(&mutexThreadTracking); //plain read only: printControl can cancel this thread inside printf
+    int threadsCount = currentThreadsCount;
+    pthread_mutex_unlock(&mutexThreadTracking);
+    printf("Active Threads: %d\n", threadsCount);
     read(STDIN_FILENO, threadBuffer, MAX_WORD_LENGTH);
     menuInput = threadBuffer[0] - '0'; //gets number value of input character
     pthread_cond_signal(&menuCondition);
@@ -534,6 +688,16 @@ int main( void ){
         exit(1);
     }
 
+    if(pthread_mutex_init(&mutexThreadTracking, NULL) != 0){ //check for failure of mutex
+        write(STDOUT_FILENO, "Error: Mutex for thread tracking failed. Terminating program.\n", 62);
+        //free menu mallocs
+        free(ThreadArgs);
+        free(threadsArray);
+        free(activeThreads);
+
+        exit(1);
+    }
+
     //initialize menu variables
     currentThreadsCount = 0;
     int maxThreadCount = DEFAULT_THREAD_COUNT;
@@ -590,6 +754,7 @@ int main( void ){
                     exitConfirmationChar = tolower(exitConfirmationChar);
 
                     if(exitConfirmationChar == 'y'){ //create new thread
+                        pthread_mutex_lock(&mutexThreadTracking);
                         currentThreadsCount++;
                         activeThreads[newThreadArgsIndex] = 1;
                         lowestFreeThreadIndex = findLowestIndex(activeThreads, maxThreadCount);
@@ -598,6 +763,7 @@ int main( void ){
                             lowestFreeThreadIndex = findLowestIndex(activeThreads, maxThreadCount);
                         }
                         pthread_create(&threadsArray[newThreadArgsIndex], NULL, spellCheck, (void*)&ThreadArgs[newThreadArgsIndex]);
+                        pthread_mutex_unlock(&mutexThreadTracking);
                         break;
                     }
                     else if(exitConfirmationChar == 'n'){ //abort
@@ -625,9 +791,12 @@ int main( void ){
                         write(STDOUT_FILENO, "closing threads.\n", 17);
                         pthread_mutex_unlock(&mutexPrintControl); //allow other threads to finish their print
 
-                        //wait for threads to finish
-                        for(int i = 0; i < currentThreadsCount; i++){
-                            if(activeThreads[i] == 1){
+                        //wait for threads to finish. Scan every slot, since cancelled threads shrink currentThreadsCount as they exit
+                        for(int i = 0; i < maxThreadCount; i++){
+                            pthread_mutex_lock(&mutexThreadTracking);
+                            char threadActive = activeThreads[i];
+                            pthread_mutex_unlock(&mutexThreadTracking);
+                            if(threadActive == 1){
                                 pthread_join(threadsArray[i], NULL);
                             }
                         }
@@ -639,6 +808,7 @@ int main( void ){
                         
                         //destroy mutex & condition
                         pthread_mutex_destroy(&mutexPrintControl);
+                        pthread_mutex_destroy(&mutexThreadTracking);
                         pthread_cond_destroy(&menuCondition);
 
                         write(STDOUT_FILENO, "Have a good day!\n", 17);